@@ -0,0 +1,1400 @@
+/* Nucleo de la simulacion: matriz, fases, estadisticas y motor.
+ El ejecutable (main.c) y el benchmark (bench.c) enlazan contra esta libreria. */
+
+// ===================================================
+// =============== LIBRERÍAS Y CONSTANTES ============
+// ===================================================
+#include "ecosistema_interno.h"
+#ifdef _WIN32
+#include <windows.h>
+#define ceder() SwitchToThread()
+#else
+#include <sched.h>
+#define ceder() sched_yield()
+#endif
+
+//avisos a TSan de la entrada y salida de la region paralela (ver tsan.supp)
+#if defined(__SANITIZE_THREAD__)
+#define CON_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define CON_TSAN 1
+#endif
+#endif
+#ifdef CON_TSAN
+void __tsan_acquire(void* direccion);
+void __tsan_release(void* direccion);
+static int borde_region;
+#define tsanAdquirir() __tsan_acquire(&borde_region)
+#define tsanLiberar() __tsan_release(&borde_region)
+#else
+#define tsanAdquirir() ((void)0)
+#define tsanLiberar() ((void)0)
+#endif
+
+#define RELLENO 16 //ints por linea de cache, separa las banderas de cada hilo
+#define RUEDA 32 //ticks de la rueda de vencimientos, mas que la vida mas larga (edadLimite)
+
+#define RESET   "\033[0m"
+#define VERDE   "\033[0;32m"
+#define AZUL    "\033[0;34m"
+#define ROJO    "\033[0;31m"
+#define GRIS    "\033[0;37m"
+
+// ===================================================
+// =================== ESTRUCTURAS INTERNAS ==========
+// ===================================================
+
+//banderas para sincronizar bandas vecinas sin barreras de todo el equipo
+typedef struct {
+    int* progreso;  // medios pasos completados por cada banda
+    int bandas;     // cantidad de bandas en que se divide la matriz
+    int impreso;    // cantidad de ticks que ya se mostraron en consola
+} Sincronizacion;
+
+//lista de celdas (i * cols + j) que crece a medida que se anota
+typedef struct {
+    int* celdas;
+    int n, cap;
+} Cubeta;
+
+/*
+Rueda de vencimientos: cada ser vivo se anota en la cubeta del tick en que
+muere por edad o por hambre, asi al final del tick solo se miran los que
+vencen y no toda la matriz. Ademas se anotan las celdas que se ocuparon en el
+tick, que son las unicas que pueden dejar encerrada a una planta.
+
+Las cubetas son por banda (y por lo tanto de un solo hilo), y cada banda tiene
+tres por tick segun quien anota: la banda de arriba, la misma o la de abajo.
+Como una fase solo escribe en las filas vecinas de su banda, nunca hay dos
+hilos anotando en la misma cubeta.
+*/
+struct Agenda {
+    Cubeta* vencen;   // [banda][origen][RUEDA]: seres vivos que pueden morir en ese tick
+    Cubeta* revisar;  // [banda][origen]: celdas ocupadas en el tick
+    int bandas;
+};
+
+//memoria de trabajo de analizarEcosistema, se reutiliza en todos los ticks
+typedef struct {
+    int* padre;              // union-find de las plantas: padre, o -tamaño en las raices
+    int* ocupacion;          // seres vivos por bloque de BLOQUE_DENSIDAD
+    int* cuenta;             // por hilo: ocupacion de la fila de bloques en curso
+    int paso_cuenta;         // ints de `cuenta` por hilo, redondeado a RELLENO
+    int* listo;              // tick+1 cuando la banda termino de mezclar su grupo
+    Estadisticas* parcial;   // resultados de cada hilo
+    Contadores* eventos;     // eventos del tick de cada hilo
+    int bloques_c;
+    int bloques;
+} Analisis;
+
+//simulacion en curso: la matriz y todo lo que se reutiliza entre ticks
+struct Mundo {
+    Celda** grid;
+    int filas, cols;
+    unsigned int semilla;
+    int hilos;              // hilos del equipo, fijos desde crearMundo
+    int tick;               // ticks ya terminados
+    int paso;               // fases corridas desde el inicio (banderas de progreso)
+    Estadisticas est;       // estadisticas del ultimo tick avanzado
+    Sincronizacion* sinc;
+    Analisis* an;
+    Agenda* agenda;
+};
+
+
+// ===================================================
+// ================== FUNCIONES HELPERS ==============
+// ===================================================
+
+/*
+Reparto del trabajo: la matriz se divide en bandas horizontales contiguas de
+al menos 2 filas y cada hilo se queda siempre con las mismas bandas. Como los
+seres vivos solo tocan su vecindad de 8, una banda solo comparte filas con la
+de arriba y la de abajo.
+
+Cada fase se corre en dos medios pasos: primero las bandas pares y despues
+las impares. Dos bandas de la misma paridad nunca tocan la misma fila, asi
+que dentro de un medio paso no hay carreras ni hace falta `omp critical`, y
+antes de trabajar una banda solo espera a sus dos vecinas (ver correrFase),
+no a todo el equipo.
+
+Con ALTO_BANDA = 0 hay dos bandas por hilo. Con ALTO_BANDA > 0 las bandas
+tienen ese alto sin importar los hilos; como los sorteos dependen solo de la
+celda (ver sortear), el resultado es el mismo con cualquier cantidad de hilos.
+*/
+
+//primera fila de la banda `banda` cuando hay `bandas` bandas
+static inline int inicioBanda(int filas, int banda, int bandas) {
+    return (int)((long)filas * banda / bandas);
+}
+
+//primera banda del hilo `id` cuando hay `hilos` hilos
+static inline int primeraBanda(int id, int hilos, int bandas) {
+    return (int)((long)bandas * id / hilos);
+}
+
+//lectura y escritura de banderas compartidas entre hilos
+static inline int leerBandera(int* bandera) {
+    int valor;
+    #pragma omp atomic read seq_cst
+    valor = *bandera;
+    return valor;
+}
+
+static inline void escribirBandera(int* bandera, int valor) {
+    (void)valor; //gcc 12 no ve el uso dentro del atomic write y avisa
+    #pragma omp atomic write seq_cst
+    *bandera = valor;
+}
+
+//espera activa hasta que la bandera llegue a `valor`, cediendo el procesador
+static inline void esperarBandera(int* bandera, int valor) {
+    while (leerBandera(bandera) < valor) {
+        ceder();
+    }
+}
+
+/*
+    Reserva las banderas de progreso, una por banda y cada una en su propia
+    linea de cache para que no se invaliden entre si.
+
+    Parámetros:
+        - filas: número de filas de la matriz.
+        - hilos: hilos que van a correr la simulacion.
+        - alto_banda: alto fijo de cada banda, o 0 para repartir por hilos.
+*/
+static Sincronizacion* crearSincronizacion(int filas, int hilos, int alto_banda) {
+    Sincronizacion* sinc = malloc(sizeof(Sincronizacion));
+    if (alto_banda > 0) {
+        sinc->bandas = filas / (alto_banda < 2 ? 2 : alto_banda);
+    } else {
+        sinc->bandas = 2 * hilos;
+        if (sinc->bandas > filas / 2) sinc->bandas = filas / 2;
+    }
+    if (sinc->bandas < 1) sinc->bandas = 1;
+    sinc->progreso = calloc(sinc->bandas * RELLENO, sizeof(int));
+    sinc->impreso = 0;
+    return sinc;
+}
+
+static void liberarSincronizacion(Sincronizacion* sinc) {
+    free(sinc->progreso);
+    free(sinc);
+}
+
+//mezcla final de murmur3: cada bit de entrada cambia todos los de salida
+static inline uint32_t mezclar(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+/*
+Sorteo reproducible para los kernels. A diferencia de rand() no tiene estado
+compartido: depende solo de la clave de la fase, de la celda y del intento,
+no de que hilo la procese ni en que orden.
+*/
+static inline uint32_t sortear(uint32_t clave, int i, int j, int intento) {
+    return mezclar(mezclar(mezclar(clave ^ (uint32_t)i) ^ (uint32_t)j) ^ (uint32_t)intento);
+}
+
+//clave de sorteo de la fase `fase` en el tick `tick`
+static inline uint32_t claveFase(uint32_t semilla, int tick, int fase) {
+    return mezclar(mezclar(semilla ^ 0x9E3779B9u) ^ (uint32_t)tick) ^ mezclar((uint32_t)fase + 1u);
+}
+
+
+/*
+    Reserva memoria dinámica para una matriz de celdas que representa 
+    el ecosistema y la inicializa con celdas vacías.
+
+    Parámetros:
+        - filas: número de filas de la matriz.
+        - cols: número de columnas de la matriz.
+
+    Retorna:
+        - Un puntero doble a Celda, que apunta a la matriz creada. Las filas
+          estan seguidas en un solo bloque (grid[0]).
+*/
+Celda** crearMatriz(int filas, int cols) {
+    Celda** grid = malloc(filas * sizeof(Celda*));
+    Celda* celdas = calloc((size_t)filas * cols, sizeof(Celda)); //inicia vacio
+    for (int i = 0; i < filas; i++) {
+        grid[i] = celdas + (size_t)i * cols;
+    }
+    return grid;
+}
+
+void liberarMatriz(Celda** grid) {
+    free(grid[0]);
+    free(grid);
+}
+
+/*
+Crea un ser vivo random a partir de un sorteo (ver sortear)
+*/
+
+Celda crearRandom(uint32_t sorteo) {
+    //random del 0 al 9
+    int r = (int)(sorteo % 10u);
+
+    if (r < 4) {
+        //la planta no usa energia, queda en 0
+        return crearSer(PLANTA, 0, 0);
+    }else if (r < 7) {      
+        return crearSer(HERVIVORO, ENERGIA(70), 0);
+    }else if (r < 9) {
+        return crearSer(CARNIVORO, ENERGIA(80), 0);
+    } 
+    return CELDA_VACIA;
+}
+
+/*
+Llena la matriz de seres vivos y los cuenta en `est` en la misma pasada.
+Cada celda sortea con su posicion, como los kernels.
+*/
+void poblarMatriz(Celda** grid, int filas, int cols, unsigned int semilla, Estadisticas* est) {
+    uint32_t clave = claveFase(semilla, -1, 0);
+    for (int i = 0; i < filas; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda s = crearRandom(sortear(clave, i, j, 0));
+            grid[i][j] = s;
+            switch (tipoDe(s)) {
+                case PLANTA: est->plantas++; break;
+                case HERVIVORO: est->hervivoros++; break;
+                case CARNIVORO: est->carnivoros++; break;
+                default: break;
+            }
+        }
+    }
+}
+
+/*Recorre la matriz de celdas y muestra en consola el contenido de cada posición.
+    - Si la celda está vacía, imprime una "B" (vacío).
+    - Si hay un ser vivo, imprime su símbolo con color según su tipo:
+        - P: Planta (VERDE)
+        - H: Herbívoro (AZUL)
+        - C: Carnívoro (ROJO)
+
+    Parámetros:
+        - grid: matriz de celdas (Celda**).
+        - filas: número de filas de la matriz.
+        - cols: número de columnas de la matriz.
+*/
+void imprimirMatriz(Celda** grid, int filas, int cols) {
+    for (int i = 0; i < filas; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda s = grid[i][j];
+            if (s == CELDA_VACIA) {
+                printf("B ");
+            } else {
+                switch (tipoDe(s)) {
+                    case PLANTA: printf(VERDE "P " RESET); break;
+                    case HERVIVORO: printf(AZUL "H " RESET); break;
+                    case CARNIVORO: printf(ROJO "C " RESET); break;
+                    default: printf(GRIS "B " RESET);
+                }
+            }
+        }
+        printf("\n");
+    }
+}
+/*
+    Calcula una huella (FNV-1a de 64 bits) de la matriz a partir de los campos
+    de cada celda despues de `tick` ticks, para comparar dos simulaciones sin
+    guardar las matrices.
+*/
+uint64_t huellaMatriz(Celda** grid, int filas, int cols, int tick) {
+    uint64_t h = 14695981039346656037ull;
+    for (int i = 0; i < filas; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda c = grid[i][j];
+            int campos[4] = {0, 0, 0, 0};
+            if (c != CELDA_VACIA) {
+                campos[0] = tipoDe(c);
+                campos[1] = accionDe(c);
+                campos[2] = edadDe(c, tick);
+                campos[3] = energiaDe(c, tick);
+            }
+            for (int k = 0; k < 4; k++) {
+                h = (h ^ (uint32_t)campos[k]) * 1099511628211ull;
+            }
+        }
+    }
+    return h;
+}
+
+// ===================================================
+// ============== ESTADO Y LIMPIEZA ==================
+// ===================================================
+//edad a partir de la cual muere cada tipo
+static inline int edadLimite(TipoSerVivo tipo) {
+    switch (tipo) {
+        case PLANTA: return 10;
+        case HERVIVORO: return 15;
+        case CARNIVORO: return 20;
+        default: return 0;
+    }
+}
+
+//1 si el ser vivo muere por edad o por hambre con `tick` ticks terminados
+static inline int vencido(Celda s, int tick) {
+    if (edadDe(s, tick) > edadLimite(tipoDe(s))) return 1;
+    return tipoDe(s) != PLANTA && energiaDe(s, tick) < ENERGIA(-3);
+}
+
+/*
+    Tick al final del cual muere el ser vivo si nada cambia, visto durante el
+    tick `tick`: el primero en que la edad supera el limite o la energia baja
+    de -3. Nunca esta a mas de edadLimite ticks, asi que entra en la rueda.
+*/
+static inline int tickVencimiento(Celda s, int tick) {
+    int faltan = edadLimite(tipoDe(s)) - edadDe(s, tick);
+    if (tipoDe(s) != PLANTA) {
+        int margen = energiaDe(s, tick) - ENERGIA(-3); //energia que le sobra antes de morir
+        int por_hambre = margen < 0 ? 0 : margen / ENERGIA(1);
+        if (por_hambre < faltan) faltan = por_hambre;
+    }
+    return tick + (faltan < 0 ? 0 : faltan);
+}
+
+static Agenda* crearAgenda(int bandas) {
+    Agenda* ag = malloc(sizeof(Agenda));
+    ag->bandas = bandas;
+    ag->vencen = calloc((size_t)bandas * 3 * RUEDA, sizeof(Cubeta));
+    ag->revisar = calloc((size_t)bandas * 3, sizeof(Cubeta));
+    return ag;
+}
+
+static void liberarAgenda(Agenda* ag) {
+    for (int k = 0; k < ag->bandas * 3 * RUEDA; k++) free(ag->vencen[k].celdas);
+    for (int k = 0; k < ag->bandas * 3; k++) free(ag->revisar[k].celdas);
+    free(ag->vencen);
+    free(ag->revisar);
+    free(ag);
+}
+
+static inline void anotar(Cubeta* cb, int celda) {
+    if (cb->n == cb->cap) {
+        cb->cap = cb->cap ? 2 * cb->cap : 16;
+        cb->celdas = realloc(cb->celdas, cb->cap * sizeof(int));
+    }
+    cb->celdas[cb->n++] = celda;
+}
+
+//banda y origen (0 arriba, 1 la misma, 2 abajo) de la fila i vista desde la banda del tramo
+static inline int cubetaDe(const Tramo* t, int i) {
+    if (i < t->ini) return (t->banda - 1) * 3 + 2;
+    if (i >= t->fin) return (t->banda + 1) * 3;
+    return t->banda * 3 + 1;
+}
+
+//anota cuando muere el ser vivo de (i, j); hay que llamarla cada vez que cambia de celda o de energia
+static inline void programarMuerte(const Tramo* t, int i, int j, int cols, Celda s) {
+    int k = cubetaDe(t, i) * RUEDA + tickVencimiento(s, t->tick) % RUEDA;
+    anotar(&t->agenda->vencen[k], i * cols + j);
+}
+
+//pone un ser vivo en (i, j), que estaba vacia, y anota su muerte y las plantas que pueden quedar encerradas
+static inline void ocupar(Celda** grid, int filas, int cols, const Tramo* t, int i, int j, Celda s) {
+    grid[i][j] = s;
+    programarMuerte(t, i, j, cols, s);
+    int ultima = -1;
+    for (int fila = i - 1; fila <= i + 1; fila++) {
+        if (fila < 0 || fila >= filas) continue;
+        int k = cubetaDe(t, fila);
+        if (k != ultima) anotar(&t->agenda->revisar[k], i * cols + j);
+        ultima = k;
+    }
+}
+
+/*
+    Anota a todos los seres vivos de la poblacion inicial, banda por banda,
+    como si acabaran de ocupar su celda.
+*/
+static void agendarPoblacion(Agenda* ag, Celda** grid, int filas, int cols) {
+    Tramo t = { .tick = 0, .agenda = ag };
+    for (t.banda = 0; t.banda < ag->bandas; t.banda++) {
+        t.ini = inicioBanda(filas, t.banda, ag->bandas);
+        t.fin = inicioBanda(filas, t.banda + 1, ag->bandas);
+        for (int i = t.ini; i < t.fin; i++) {
+            for (int j = 0; j < cols; j++) {
+                if (grid[i][j] != CELDA_VACIA) {
+                    ocupar(grid, filas, cols, &t, i, j, grid[i][j]);
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Elimina los seres vivos que mueren por edad o por hambre en este tick.
+ *
+ * Antes se recorria toda la matriz para sumar edad y restar energia, y otra
+ * vez para buscar a los muertos; ahora edad y energia salen del tick y solo
+ * se miran las celdas anotadas en la rueda para este tick. Las anotaciones
+ * viejas (el ser vivo se movio, comio o ya murio) se descartan al revisarlas.
+ *
+ * @param grid Matriz de celdas a limpiar.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, contadores del hilo y agenda.
+ */
+void limpiarVencidos(Celda** grid, int filas, int cols, const Tramo* t) {
+    (void)filas; //misma firma que las demas fases
+    for (int origen = 0; origen < 3; origen++) {
+        Cubeta* cb = &t->agenda->vencen[(t->banda * 3 + origen) * RUEDA + t->tick % RUEDA];
+        for (int k = 0; k < cb->n; k++) {
+            int i = cb->celdas[k] / cols, j = cb->celdas[k] % cols;
+            Celda s = grid[i][j];
+            // al terminar el tick ya paso un tick mas
+            if (s != CELDA_VACIA && vencido(s, t->tick + 1)) {
+                grid[i][j] = CELDA_VACIA;
+                t->cont->muertos[tipoDe(s)]++;
+            }
+        }
+        cb->n = 0;
+    }
+}
+
+
+/**
+ * @brief Verifica si una planta está rodeada por otros seres vivos.
+ * 
+ * @param grid Matriz de celdas.
+ * @param i Índice de fila de la planta.
+ * @param j Índice de columna de la planta.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @return int 1 si la planta está rodeada, 0 en caso contrario.
+ */
+// planta encerrada
+static inline int ansiedadPlantas(Celda** grid, int i, int j, int filas, int cols) {
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            if (dx == 0 && dy == 0) continue;
+            int ni = i + dx, nj = j + dy;
+            if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                if (grid[ni][nj] == CELDA_VACIA) {
+                    return 0;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+
+/**
+ * @brief Elimina las plantas que quedaron encerradas por otros seres vivos.
+ *
+ * Una planta solo puede quedar encerrada si en este tick se ocupo alguna celda
+ * de su vecindad (o nacio ella), asi que se revisan las vecinas de las celdas
+ * anotadas en `revisar` y no toda la matriz. Cada banda solo elimina plantas
+ * de sus propias filas.
+ *
+ * @param grid Matriz de celdas a limpiar.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, contadores del hilo y agenda.
+ */
+void limpiarMuertos(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int origen = 0; origen < 3; origen++) {
+        Cubeta* cb = &t->agenda->revisar[t->banda * 3 + origen];
+        for (int k = 0; k < cb->n; k++) {
+            int ci = cb->celdas[k] / cols, cj = cb->celdas[k] % cols;
+            for (int i = ci - 1; i <= ci + 1; i++) {
+                if (i < t->ini || i >= t->fin) continue;
+                for (int j = cj - 1; j <= cj + 1; j++) {
+                    if (j < 0 || j >= cols) continue;
+                    if (tipoDe(grid[i][j]) == PLANTA && ansiedadPlantas(grid, i, j, filas, cols)) {
+                        grid[i][j] = CELDA_VACIA;
+                        t->cont->muertos[PLANTA]++;
+                    }
+                }
+            }
+        }
+        cb->n = 0;
+    }
+}
+
+
+/**
+ * @brief Reinicia las acciones de todos los seres vivos en la matriz a NINGUNA.
+ * 
+ * @param grid Matriz de celdas a actualizar.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+void limpiarAcciones(Celda** grid, int filas, int cols, const Tramo* t) {
+    (void)filas; //misma firma que las demas fases
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            if (grid[i][j] != CELDA_VACIA) {
+                grid[i][j] = conAccion(grid[i][j], NINGUNA);
+            }
+        }
+    }
+}
+
+// ===================================================
+// ==================== REPRODUCCIÓN =================
+// ===================================================
+
+
+
+/**
+ * @brief Maneja la reproducción de las plantas en la matriz.
+ * 
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+void reproducirPlantas(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda ocupante = grid[i][j];
+            if (tipoDe(ocupante) == PLANTA && accionDe(ocupante) == NINGUNA) {
+
+                if (sortear(t->clave, i, j, 0) % 100 < 30) {
+
+                    for (int dx = -1; dx <= 1; dx++) {
+                        for (int dy = -1; dy <= 1; dy++) {
+                            if (dx == 0 && dy == 0) continue;
+
+                            int ni = i + dx;
+                            int nj = j + dy;
+
+                            if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                                if (grid[ni][nj] == CELDA_VACIA) {
+                                    ocupar(grid, filas, cols, t, ni, nj, crearSer(PLANTA, 0, t->tick));
+                                    grid[i][j] = conAccion(ocupante, REPRODUCIRSE);
+                                    t->cont->nacidos[PLANTA]++;
+                                    goto siguiente_planta;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+siguiente_planta:;
+        }
+    }
+}
+
+
+/**
+ * @brief Maneja la reproducción de los herbívoros en la matriz.
+ * 
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+void reproducirHervivoros(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda h = grid[i][j];
+
+            if (tipoDe(h) == HERVIVORO && accionDe(h) == NINGUNA && energiaDe(h, t->tick) >= ENERGIA(3)) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if (dx == 0 && dy == 0) continue;
+
+                        int ni = i + dx;
+                        int nj = j + dy;
+
+                        if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                            if (grid[ni][nj] == CELDA_VACIA) {
+                                ocupar(grid, filas, cols, t, ni, nj, crearSer(HERVIVORO, ENERGIA(2), t->tick));
+                                grid[i][j] = conAccion(conEnergia(h, energiaDe(h, t->tick) - ENERGIA(2), t->tick), REPRODUCIRSE);
+                                programarMuerte(t, i, j, cols, grid[i][j]);
+                                t->cont->nacidos[HERVIVORO]++;
+                                goto siguiente;
+                            }
+                        }
+                    }
+                }
+            }
+siguiente:;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Maneja la reproducción de los carnívoros en la matriz.
+ * 
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+void reproducirCarnivoros(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda c = grid[i][j];
+
+            if (tipoDe(c) == CARNIVORO && accionDe(c) == NINGUNA && energiaDe(c, t->tick) >= ENERGIA(3)) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if (dx == 0 && dy == 0) continue;
+
+                        int ni = i + dx;
+                        int nj = j + dy;
+
+                        if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                            if (grid[ni][nj] == CELDA_VACIA) {
+                                ocupar(grid, filas, cols, t, ni, nj, crearSer(CARNIVORO, ENERGIA(2), t->tick));
+                                grid[i][j] = conAccion(conEnergia(c, energiaDe(c, t->tick) - ENERGIA(2), t->tick), REPRODUCIRSE);
+                                programarMuerte(t, i, j, cols, grid[i][j]);
+                                t->cont->nacidos[CARNIVORO]++;
+                                goto siguiente;
+                            }
+                        }
+                    }
+                }
+            }
+siguiente:;
+        }
+    }
+}
+
+// ===================================================
+// ================ CONSUMO DE RECURSOS ==============
+// ===================================================
+
+
+
+/**
+ * @brief Maneja el consumo de plantas por parte de los herbívoros en la matriz.
+ * 
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+void herbivorosConsume(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda h = grid[i][j];
+
+            if (tipoDe(h) == HERVIVORO && accionDe(h) == NINGUNA) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if (dx == 0 && dy == 0) continue;
+
+                        int ni = i + dx;
+                        int nj = j + dy;
+
+                        if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+
+                            if (tipoDe(grid[ni][nj]) == PLANTA) {
+                                if (sortear(t->clave, i, j, 0) % 100 < 50) {
+                                    grid[ni][nj] = CELDA_VACIA;
+                                    grid[i][j] = conAccion(conEnergia(h, energiaDe(h, t->tick) + ENERGIA(1), t->tick), COMER);
+                                    programarMuerte(t, i, j, cols, grid[i][j]);
+                                    t->cont->muertos[PLANTA]++;
+                                }
+                                goto siguiente_herbivoro;
+                            }
+                        }
+                    }
+                }
+            }
+siguiente_herbivoro:;
+        }
+    }
+}
+
+
+/**
+ * @brief Maneja el consumo de herbívoros o plantas por parte de los carnívoros en la matriz.
+ * 
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+void carnivorosConsume(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda c = grid[i][j];
+
+            if (tipoDe(c) == CARNIVORO && accionDe(c) == NINGUNA) {
+                
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if (dx == 0 && dy == 0) continue;
+
+                        int ni = i + dx;
+                        int nj = j + dy;
+
+                        if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                            
+                            TipoSerVivo vecino = tipoDe(grid[ni][nj]);
+                            if (vecino == HERVIVORO || vecino == PLANTA) {
+                                if (sortear(t->clave, i, j, 0) % 100 < 50) {
+                                    int ganancia = vecino == HERVIVORO ? ENERGIA(2) : ENERGIA(1);
+                                    grid[ni][nj] = CELDA_VACIA;
+                                    grid[i][j] = conAccion(conEnergia(c, energiaDe(c, t->tick) + ganancia, t->tick), COMER);
+                                    programarMuerte(t, i, j, cols, grid[i][j]);
+                                    t->cont->muertos[vecino]++;
+                                }
+                                goto siguiente_carnivoro;
+                            }
+                        }
+                    }
+                }
+            }
+siguiente_carnivoro:;
+        }
+    }
+}
+
+
+// ===================================================
+// ======================== MOVIMIENTO =====================
+// ===================================================
+
+
+
+/**
+ * @brief Mueve a los herbívoros en la matriz, evitando depredadores.
+ * 
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+// Movimiento de Herbívoros
+void moverHerbivoros(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda h = grid[i][j];
+            if (tipoDe(h) == HERVIVORO && accionDe(h) == NINGUNA) {
+                
+                int peligro = 0;
+                // Detectar si hay un carnívoro cerca
+                for (int dx = -1; dx <= 1 && !peligro; dx++) {
+                    for (int dy = -1; dy <= 1 && !peligro; dy++) {
+                        if (dx == 0 && dy == 0) continue;
+                        int ni = i + dx, nj = j + dy;
+                        if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                            if (tipoDe(grid[ni][nj]) == CARNIVORO) {
+                                peligro = 1;
+                            }
+                        }
+                    }
+                }
+
+                // Intentar moverse a celda vacía
+                int dirs[8][2] = {
+                    {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+                    {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+                };
+                int mov_realizado = 0;
+                for (int intento = 0; intento < 8 && !mov_realizado; intento++) {
+                    // Selecciona aleatoriamente una de las 8 direcciones posibles
+                    int idx = sortear(t->clave, i, j, intento) % 8; // aleatorio
+                    int ni = i + dirs[idx][0];
+                    int nj = j + dirs[idx][1];
+                    if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                        if (grid[ni][nj] == CELDA_VACIA) {  // Comprueba si la celda destino está vacía
+                            // cambio de celda
+                            ocupar(grid, filas, cols, t, ni, nj, conAccion(h, MOVER));
+                            grid[i][j] = CELDA_VACIA;
+                            mov_realizado = 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+
+/**
+ * @brief Mueve a los carnívoros en la matriz, buscando presas.
+ * 
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param t Banda de filas, clave de sorteo y contadores del hilo.
+ */
+// Movimiento de Carnívoros
+void moverCarnivoros(Celda** grid, int filas, int cols, const Tramo* t) {
+    for (int i = t->ini; i < t->fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            Celda c = grid[i][j];
+            if (tipoDe(c) == CARNIVORO && accionDe(c) == NINGUNA) {
+
+                int presa_cerca = 0;
+                // Detectar si hay herbívoro cerca
+                for (int dx = -1; dx <= 1 && !presa_cerca; dx++) {
+                    for (int dy = -1; dy <= 1 && !presa_cerca; dy++) {
+                        if (dx == 0 && dy == 0) continue;
+                        int ni = i + dx, nj = j + dy;
+                        if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                            if (tipoDe(grid[ni][nj]) == HERVIVORO) {
+                                presa_cerca = 1;
+                            }
+                        }
+                    }
+                }
+
+                // Si no hay presa cerca, moverse
+                if (!presa_cerca) {
+                    int dirs[8][2] = {
+                        {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+                        {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+                    };
+                    int mov_realizado = 0;
+                    for (int intento = 0; intento < 8 && !mov_realizado; intento++) {
+                        int idx = sortear(t->clave, i, j, intento) % 8;
+                        int ni = i + dirs[idx][0];
+                        int nj = j + dirs[idx][1];
+                        if (ni >= 0 && ni < filas && nj >= 0 && nj < cols) {
+                            if (grid[ni][nj] == CELDA_VACIA) {
+                                ocupar(grid, filas, cols, t, ni, nj, conAccion(c, MOVER));
+                                grid[i][j] = CELDA_VACIA;
+                                mov_realizado = 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+// ===================================================
+// ============ ESTADÍSTICAS ESPACIALES ==============
+// ===================================================
+
+/*
+Busca la raiz del grupo de x comprimiendo el camino a la mitad. Las raices
+guardan el tamaño del grupo en negativo, asi que padre[x] < 0 marca la raiz.
+Solo se usa sobre nodos del grupo de bandas que maneja el hilo que la llama.
+*/
+static inline int buscarRaiz(int* padre, int x) {
+    while (padre[x] >= 0) {
+        if (padre[padre[x]] >= 0) padre[x] = padre[padre[x]];
+        x = padre[x];
+    }
+    return x;
+}
+
+/*
+Une los grupos de las plantas a y b. La raiz queda en el indice menor y
+guarda el tamaño del grupo, asi el grupo mas grande y la cantidad de grupos
+salen de las uniones sin recorrer la matriz otra vez.
+*/
+static inline void unirPlantas(Analisis* an, int a, int b, Estadisticas* e) {
+    int ra = buscarRaiz(an->padre, a);
+    int rb = buscarRaiz(an->padre, b);
+    if (ra == rb) return;
+    if (rb < ra) {
+        int tmp = ra;
+        ra = rb;
+        rb = tmp;
+    }
+    an->padre[ra] += an->padre[rb];
+    an->padre[rb] = ra;
+    e->clusters--;
+    if (-an->padre[ra] > e->cluster_mayor) e->cluster_mayor = -an->padre[ra];
+}
+
+//une la planta (i, j) con las plantas de la fila de arriba
+static inline void unirConFilaSuperior(Celda** grid, Analisis* an, int i, int j, int cols, Estadisticas* e) {
+    int k = i * cols + j;
+    for (int dy = -1; dy <= 1; dy++) {
+        int nj = j + dy;
+        if (nj >= 0 && nj < cols && tipoDe(grid[i - 1][nj]) == PLANTA) {
+            unirPlantas(an, k, k - cols + dy, e);
+        }
+    }
+}
+
+/*
+Suma a `ocupacion` lo contado por el hilo en la fila de bloques `bf` y deja
+`cuenta` en cero. Si las filas del bloque son todas del hilo nadie mas lo
+toca y se suma directo; solo los bloques partidos por una frontera entre
+hilos necesitan la suma atomica.
+*/
+static void volcarOcupacion(Analisis* an, int* cuenta, int bf, int filas, int ini, int fin) {
+    int primera = bf * BLOQUE_DENSIDAD;
+    int ultima = primera + BLOQUE_DENSIDAD < filas ? primera + BLOQUE_DENSIDAD : filas;
+    int* ocupacion = &an->ocupacion[bf * an->bloques_c];
+    if (primera >= ini && ultima <= fin) {
+        for (int bc = 0; bc < an->bloques_c; bc++) {
+            ocupacion[bc] += cuenta[bc];
+            cuenta[bc] = 0;
+        }
+        return;
+    }
+    for (int bc = 0; bc < an->bloques_c; bc++) {
+        if (cuenta[bc] == 0) continue;
+        #pragma omp atomic
+        ocupacion[bc] += cuenta[bc];
+        cuenta[bc] = 0;
+    }
+}
+
+//1 si el hervivoro de (i, j) tiene un carnivoro en su vecindad de 8
+static inline int carnivoroAlLado(Celda** grid, int i, int j, int filas, int cols) {
+    for (int ni = i - 1; ni <= i + 1; ni++) {
+        for (int nj = j - 1; nj <= j + 1; nj++) {
+            if (ni >= 0 && ni < filas && nj >= 0 && nj < cols && tipoDe(grid[ni][nj]) == CARNIVORO) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+    Reserva la memoria de trabajo del analisis para una matriz de filas x cols
+    y hasta `hilos` hilos.
+*/
+static Analisis* crearAnalisis(int filas, int cols, int hilos) {
+    Analisis* an = malloc(sizeof(Analisis));
+    int bloques_f = (filas + BLOQUE_DENSIDAD - 1) / BLOQUE_DENSIDAD;
+    an->bloques_c = (cols + BLOQUE_DENSIDAD - 1) / BLOQUE_DENSIDAD;
+    an->bloques = bloques_f * an->bloques_c;
+    an->padre = malloc((size_t)filas * cols * sizeof(int));
+    an->ocupacion = calloc(an->bloques, sizeof(int));
+    an->paso_cuenta = (an->bloques_c + RELLENO - 1) / RELLENO * RELLENO;
+    an->cuenta = calloc((size_t)hilos * an->paso_cuenta, sizeof(int));
+    an->listo = calloc(hilos * RELLENO, sizeof(int));
+    an->parcial = calloc(hilos, sizeof(Estadisticas));
+    an->eventos = calloc(hilos, sizeof(Contadores));
+    return an;
+}
+
+static void liberarAnalisis(Analisis* an) {
+    free(an->padre);
+    free(an->ocupacion);
+    free(an->cuenta);
+    free(an->listo);
+    free(an->parcial);
+    free(an->eventos);
+    free(an);
+}
+
+/**
+ * @brief Calcula las métricas espaciales del ecosistema en una sola pasada.
+ *
+ * La llaman todos los hilos del equipo. Cada uno recorre las filas de sus
+ * bandas: cuenta seres vivos y hervivoros con un carnivoro al lado, acumula
+ * la ocupación por bloque y arma un union-find local de las plantas. Lee
+ * también la fila vecina de las bandas de al lado, así que hay que llamarla
+ * después de esperarVecinas. Después los hilos se mezclan de a pares en
+ * log2(hilos) rondas uniendo solo la fila de frontera; cada hilo espera
+ * únicamente al hilo con el que se mezcla, no a todo el equipo. El hilo 0
+ * junta también los eventos del tick (Contadores) y los deja en cero.
+ *
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param tick Tick actual, marca las banderas de mezcla.
+ * @param bandas Cantidad de bandas de la simulación (Sincronizacion).
+ * @param an Memoria de trabajo (crearAnalisis).
+ * @param est Estructura donde se guardan los resultados.
+ * @return 1 en el hilo que tiene los resultados completos (el 0), 0 en los demás.
+ */
+static int analizarEcosistema(Celda** grid, int filas, int cols, int tick, int bandas, Analisis* an, Estadisticas* est) {
+    int hilos = omp_get_num_threads();
+    int id = omp_get_thread_num();
+    int ini = inicioBanda(filas, primeraBanda(id, hilos, bandas), bandas);
+    int fin = inicioBanda(filas, primeraBanda(id + 1, hilos, bandas), bandas);
+    int* cuenta = &an->cuenta[id * an->paso_cuenta];
+    Estadisticas e = {0};
+
+    // conteo, ocupacion y union-find dentro de las filas del hilo
+    for (int i = ini; i < fin; i++) {
+        for (int j = 0; j < cols; j++) {
+            int k = i * cols + j;
+            Celda s = grid[i][j];
+            if (s == CELDA_VACIA) continue;
+
+            cuenta[j / BLOQUE_DENSIDAD]++;
+
+            switch (tipoDe(s)) {
+                case PLANTA: e.plantas++; break;
+                case HERVIVORO:
+                    e.hervivoros++;
+                    e.en_peligro += carnivoroAlLado(grid, i, j, filas, cols);
+                    break;
+                case CARNIVORO: e.carnivoros++; break;
+                default: break;
+            }
+            if (tipoDe(s) != PLANTA) continue;
+
+            // cada planta empieza como su propio grupo; padre solo se
+            // escribe en las plantas, las demas celdas se reconocen por el tipo
+            an->padre[k] = -1;
+            e.clusters++;
+            if (e.cluster_mayor == 0) e.cluster_mayor = 1;
+
+            // solo se miran vecinos ya visitados: izquierda y fila de arriba
+            if (j > 0 && tipoDe(grid[i][j - 1]) == PLANTA) {
+                unirPlantas(an, k, k - 1, &e);
+            }
+            if (i > ini) {
+                unirConFilaSuperior(grid, an, i, j, cols, &e);
+            }
+        }
+        // al cerrar una fila de bloques (o las filas del hilo) se vuelca
+        if ((i + 1) % BLOQUE_DENSIDAD == 0 || i + 1 == fin) {
+            volcarOcupacion(an, cuenta, i / BLOQUE_DENSIDAD, filas, ini, fin);
+        }
+    }
+
+    // mezcla en arbol: en cada ronda los pares de grupos de hilos son disjuntos
+    for (int paso = 1; paso < hilos && id % (2 * paso) == 0; paso *= 2) {
+        if (id + paso < hilos) {
+            esperarBandera(&an->listo[(id + paso) * RELLENO], tick + 1);
+            int ultimo = id + 2 * paso < hilos ? id + 2 * paso : hilos;
+            int frontera = inicioBanda(filas, primeraBanda(id + paso, hilos, bandas), bandas);
+            int limite = inicioBanda(filas, primeraBanda(ultimo, hilos, bandas), bandas);
+            if (frontera <= ini || frontera >= limite) continue; //algun grupo sin filas
+            for (int j = 0; j < cols; j++) {
+                if (tipoDe(grid[frontera][j]) == PLANTA) {
+                    unirConFilaSuperior(grid, an, frontera, j, cols, &e);
+                }
+            }
+        }
+    }
+    an->parcial[id] = e;
+    escribirBandera(&an->listo[id * RELLENO], tick + 1);
+
+    if (id != 0) return 0;
+
+    // el hilo 0 ya espero (en cadena) a todos los hilos: junta los parciales
+    *est = an->parcial[0];
+    for (int h = 1; h < hilos; h++) {
+        Estadisticas* p = &an->parcial[h];
+        est->plantas += p->plantas;
+        est->hervivoros += p->hervivoros;
+        est->carnivoros += p->carnivoros;
+        est->clusters += p->clusters;
+        est->en_peligro += p->en_peligro;
+        if (p->cluster_mayor > est->cluster_mayor) est->cluster_mayor = p->cluster_mayor;
+    }
+    for (int h = 0; h < hilos; h++) {
+        Contadores* c = &an->eventos[h];
+        for (int tipo = PLANTA; tipo <= CARNIVORO; tipo++) {
+            est->nacidos[tipo] += c->nacidos[tipo];
+            est->muertos[tipo] += c->muertos[tipo];
+        }
+        memset(c, 0, sizeof(Contadores)); //listo para el siguiente tick
+    }
+
+    // varianza de la densidad (ocupados / area) de cada bloque
+    double suma = 0.0, suma2 = 0.0;
+    for (int b = 0; b < an->bloques; b++) {
+        int alto = filas - (b / an->bloques_c) * BLOQUE_DENSIDAD;
+        int ancho = cols - (b % an->bloques_c) * BLOQUE_DENSIDAD;
+        if (alto > BLOQUE_DENSIDAD) alto = BLOQUE_DENSIDAD;
+        if (ancho > BLOQUE_DENSIDAD) ancho = BLOQUE_DENSIDAD;
+        double d = (double)an->ocupacion[b] / (alto * ancho);
+        suma += d;
+        suma2 += d * d;
+        an->ocupacion[b] = 0; //listo para el siguiente tick
+    }
+    double media = suma / an->bloques;
+
+    est->cluster_medio = est->clusters > 0 ? (float)est->plantas / est->clusters : 0.0f;
+    est->varianza_densidad = (float)(suma2 / an->bloques - media * media);
+    return 1;
+}
+
+
+
+// ===================================================
+// ======================== MOTOR ====================
+// ===================================================
+
+//fases de un tick, en orden
+static const Fase FASES[] = {
+    // Movimiento (huida/búsqueda)
+    moverHerbivoros, moverCarnivoros,
+    // Consumo de recursos
+    herbivorosConsume, carnivorosConsume,
+    // Reproducción
+    reproducirPlantas, reproducirHervivoros, reproducirCarnivoros,
+    // Muertes por edad y hambre, y plantas encerradas
+    limpiarVencidos, limpiarMuertos
+};
+#define NUM_FASES ((int)(sizeof(FASES) / sizeof(FASES[0])))
+
+/**
+ * @brief Corre una fase sobre las bandas del hilo en dos medios pasos.
+ *
+ * En el medio paso par trabajan las bandas pares y en el impar las impares.
+ * Antes de trabajar, cada banda espera a que sus dos vecinas terminen el
+ * medio paso anterior, y al terminar lo anota en su bandera de progreso.
+ *
+ * @param fase Kernel a correr.
+ * @param grid Matriz de celdas.
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param sinc Banderas de progreso de las bandas.
+ * @param paso Número de fase desde el inicio de la simulación.
+ * @param t Clave de sorteo, contadores del hilo, tick y agenda; las filas y la
+ *        banda las completa correrFase.
+ */
+static void correrFase(Fase fase, Celda** grid, int filas, int cols, Sincronizacion* sinc, int paso, Tramo t) {
+    int hilos = omp_get_num_threads();
+    int id = omp_get_thread_num();
+    int primera = primeraBanda(id, hilos, sinc->bandas);
+    int ultima = primeraBanda(id + 1, hilos, sinc->bandas);
+
+    for (int medio = 0; medio < 2; medio++) {
+        int k = 2 * paso + medio; //medio paso global
+        for (int b = primera + ((primera + medio) & 1); b < ultima; b += 2) {
+            if (b > 0) esperarBandera(&sinc->progreso[(b - 1) * RELLENO], k);
+            if (b + 1 < sinc->bandas) esperarBandera(&sinc->progreso[(b + 1) * RELLENO], k);
+
+            t.banda = b;
+            t.ini = inicioBanda(filas, b, sinc->bandas);
+            t.fin = inicioBanda(filas, b + 1, sinc->bandas);
+            fase(grid, filas, cols, &t);
+
+            escribirBandera(&sinc->progreso[b * RELLENO], k + 1);
+        }
+    }
+}
+
+
+/*
+    Espera a que las bandas pegadas a las del hilo lleguen al medio paso `k`,
+    para poder leer su fila de frontera (analizarEcosistema). Cada banda solo
+    anota su propio medio paso, asi que al cerrar una fase las pares quedan en
+    2 * paso - 1 y las impares en 2 * paso.
+*/
+static void esperarVecinas(Sincronizacion* sinc, int k) {
+    int hilos = omp_get_num_threads();
+    int id = omp_get_thread_num();
+    int primera = primeraBanda(id, hilos, sinc->bandas);
+    int ultima = primeraBanda(id + 1, hilos, sinc->bandas);
+    if (primera > 0) esperarBandera(&sinc->progreso[(primera - 1) * RELLENO], k);
+    if (ultima < sinc->bandas) esperarBandera(&sinc->progreso[ultima * RELLENO], k);
+}
+
+
+// ===================================================
+// ======================== MUNDO ====================
+// ===================================================
+
+/**
+ * @brief Reserva un mundo vacío con sus estructuras de trabajo.
+ *
+ * Los hilos se fijan aquí (omp_get_max_threads): todos los avanzarMundo de
+ * este mundo usan la misma cantidad.
+ *
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param semilla Semilla para poblar la matriz y para los sorteos.
+ * @param alto_banda 0 reparte las bandas según los hilos; con un alto fijo el
+ *        resultado es el mismo con cualquier cantidad de hilos.
+ * @return El mundo, o NULL si las dimensiones no son válidas.
+ */
+Mundo* crearMundo(int filas, int cols, unsigned int semilla, int alto_banda) {
+    if (filas < 1 || cols < 1) return NULL;
+    Mundo* m = calloc(1, sizeof(Mundo));
+    m->filas = filas;
+    m->cols = cols;
+    m->semilla = semilla;
+    m->hilos = omp_get_max_threads();
+    m->grid = crearMatriz(filas, cols);
+    m->sinc = crearSincronizacion(filas, m->hilos, alto_banda);
+    m->an = crearAnalisis(filas, cols, m->hilos);
+    m->agenda = crearAgenda(m->sinc->bandas);
+    return m;
+}
+
+/**
+ * @brief Llena el mundo de seres vivos al azar (con la semilla del mundo).
+ *
+ * @return 0, o -1 si el mundo ya avanzó: la población inicial nace en el tick 0.
+ */
+int poblarMundo(Mundo* m) {
+    if (m->tick != 0) return -1;
+    memset(&m->est, 0, sizeof(Estadisticas));
+    poblarMatriz(m->grid, m->filas, m->cols, m->semilla, &m->est);
+    agendarPoblacion(m->agenda, m->grid, m->filas, m->cols);
+    return 0;
+}
+
+/*
+    Lo que corre cada hilo del equipo de correrTicks: los ticks [inicio, fin)
+    sobre sus bandas. Va en su propia funcion para que la region paralela
+    solo lea sus argumentos (ver tsan.supp).
+
+    Sin nada que mostrar, el analisis se corre solo en el ultimo tick: los
+    intermedios no los lee nadie, y asi las bandas pasan de un tick al
+    siguiente sin esperar al hilo 0. Los Contadores no se vacian hasta el
+    analisis, asi que nacidos y muertos suman todos los ticks de la llamada.
+*/
+static void correrEquipo(Mundo* m, int inicio, int fin, int mostrar) {
+    tsanAdquirir();
+    int paso = m->paso;
+    Estadisticas est;
+    Contadores* cont = &m->an->eventos[omp_get_thread_num()];
+
+    // Para cada tick de la simulación
+    for (int tick = inicio; tick < fin; tick++){
+        // no se toca la matriz hasta que el tick anterior se termine de
+        // mostrar; sin mostrar, el unico analisis es el del ultimo tick
+        if (mostrar) esperarBandera(&m->sinc->impreso, tick);
+
+        for (int f = 0; f < NUM_FASES; f++) {
+            Tramo t = { .clave = claveFase(m->semilla, tick, f), .cont = cont, .tick = tick, .agenda = m->agenda };
+            correrFase(FASES[f], m->grid, m->filas, m->cols, m->sinc, paso++, t);
+        }
+
+        if (!mostrar && tick < fin - 1) continue;
+
+        // Contar, medir y mostrar estado: el analisis lee la fila de al
+        // lado de las bandas vecinas, que tienen que terminar de limpiar
+        esperarVecinas(m->sinc, 2 * paso - 1);
+        if (analizarEcosistema(m->grid, m->filas, m->cols, tick, m->sinc->bandas, m->an, &est)) {
+            if (mostrar) {
+                printf("tick: %d\n", tick);
+                printf("Distribucion:\n");
+                printf("Plantas: %d\nHervivoros: %d\nCarnivoros: %d\n", est.plantas, est.hervivoros, est.carnivoros);
+                printf("Grupos de plantas: %d (mayor: %d, promedio: %.2f)\n", est.clusters, est.cluster_mayor, est.cluster_medio);
+                printf("Hervivoros en peligro: %d\n", est.en_peligro);
+                printf("Varianza de densidad: %.4f\n", est.varianza_densidad);
+                if (mostrar == MOSTRAR_MATRIZ) imprimirMatriz(m->grid, m->filas, m->cols);
+                printf("\n\n");
+            }
+            m->est = est;
+            escribirBandera(&m->sinc->impreso, tick + 1);
+        }
+    }
+    tsanLiberar();
+}
+
+/**
+ * @brief Corre `ticks` ticks con un solo equipo de hilos.
+ *
+ * Las banderas de progreso llevan la cuenta desde el inicio del mundo, así
+ * que cada llamada sigue donde terminó la anterior.
+ *
+ * @param m Mundo a avanzar.
+ * @param ticks Cantidad de ticks a simular.
+ * @param mostrar MOSTRAR_NADA, MOSTRAR_CONTEOS o MOSTRAR_MATRIZ.
+ */
+static void correrTicks(Mundo* m, int ticks, int mostrar) {
+    int inicio = m->tick;
+    int fin = m->tick + ticks;
+
+    // Un solo equipo de hilos para todos los ticks; entre fases cada banda
+    // solo espera a sus vecinas (correrFase).
+    tsanLiberar();
+    #pragma omp parallel num_threads(m->hilos)
+    correrEquipo(m, inicio, fin, mostrar);
+    tsanAdquirir();
+
+    m->tick = fin;
+    m->paso += ticks * NUM_FASES;
+}
+
+/**
+ * @brief Avanza el mundo `ticks` ticks sin imprimir nada.
+ *
+ * Conviene pedir varios ticks por llamada: el equipo de hilos se arma una
+ * sola vez por llamada y las estadísticas se calculan solo al final.
+ *
+ * @return 0, o -1 si `ticks` es negativo.
+ */
+int avanzarMundo(Mundo* m, int ticks) {
+    if (ticks < 0) return -1;
+    if (ticks > 0) correrTicks(m, ticks, MOSTRAR_NADA);
+    return 0;
+}
+
+/*
+    Estadisticas del ultimo tick avanzado (antes del primero, solo los
+    conteos iniciales). Nacidos y muertos suman todos los ticks de la ultima
+    llamada a avanzarMundo.
+*/
+void estadisticasMundo(const Mundo* m, Estadisticas* est) {
+    *est = m->est;
+}
+
+//copia las celdas fila por fila en `destino`, que tiene lugar para filas * cols
+void copiarMundo(const Mundo* m, Celda* destino) {
+    memcpy(destino, m->grid[0], (size_t)m->filas * m->cols * sizeof(Celda));
+}
+
+/*
+    Vista de solo lectura de la matriz, sin copiarla. Las filas estan seguidas
+    en un solo bloque (crearMatriz). Sirve hasta el proximo avanzarMundo o
+    liberarMundo.
+*/
+Vista vistaMundo(const Mundo* m) {
+    Vista v;
+    v.datos = m->grid[0];
+    v.filas = m->filas;
+    v.cols = m->cols;
+    v.paso_fila = (ptrdiff_t)m->cols * (ptrdiff_t)sizeof(Celda);
+    v.paso_col = (ptrdiff_t)sizeof(Celda);
+    v.dato = DATO_CELDA;
+    v.tick = m->tick;
+    return v;
+}
+
+void liberarMundo(Mundo* m) {
+    if (!m) return;
+    liberarAgenda(m->agenda);
+    liberarAnalisis(m->an);
+    liberarSincronizacion(m->sinc);
+    liberarMatriz(m->grid);
+    free(m);
+}
+
+
+/**
+ * @brief Corre la simulación completa: crea y puebla un mundo, lo avanza y lo libera.
+ *
+ * @param filas Número de filas de la matriz.
+ * @param cols Número de columnas de la matriz.
+ * @param ticks Cantidad de ticks a simular.
+ * @param semilla Semilla para poblar la matriz y para los sorteos.
+ * @param alto_banda 0 reparte las bandas según los hilos; con un alto fijo el
+ *        resultado es el mismo con cualquier cantidad de hilos.
+ * @param mostrar MOSTRAR_NADA, MOSTRAR_CONTEOS o MOSTRAR_MATRIZ.
+ * @return 0, o -1 si las dimensiones no son válidas.
+ */
+int simular(int filas, int cols, int ticks, unsigned int semilla, int alto_banda, int mostrar) {
+    Mundo* m = crearMundo(filas, cols, semilla, alto_banda);
+    if (m == NULL) return -1;
+    poblarMundo(m);
+
+    if (mostrar) {
+        printf("Distribucion inicial:\n");
+        printf("\nPlantas: %d\nHervivoros: %d\nCarnivoros: %d\n", m->est.plantas, m->est.hervivoros, m->est.carnivoros);
+        if (mostrar == MOSTRAR_MATRIZ) imprimirMatriz(m->grid, m->filas, m->cols);
+        printf("\n\n");
+    }
+
+    if (ticks > 0) correrTicks(m, ticks, mostrar);
+    liberarMundo(m);
+    return 0;
+}
@@ -0,0 +1,179 @@
+/* Interfaz publica de libecosistema: crear un mundo, avanzarlo y leer sus
+ estadisticas y su matriz. Los kernels y el resto de las piezas internas
+ estan en ecosistema_interno.h.
+*/
+
+#ifndef ECOSISTEMA_H
+#define ECOSISTEMA_H
+
+// ===================================================
+// =============== LIBRERÍAS Y CONSTANTES ============
+// ===================================================
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ALTO_BANDA_DETERMINISTA 2 //alto de banda del modo determinista (ver crearMundo)
+
+//formato de la celda empaquetada (ver Celda)
+#define CELDA_VACIA 0u
+#define DESP_ACCION 2
+#define DESP_NACIMIENTO 5
+#define DESP_ENERGIA 13
+#define EDAD_MAX 255 //la edad se lee modulo 256, los limites de vida quedan muy por debajo
+#define ESCALA_ENERGIA 16 //la energia se guarda en dieciseisavos
+#define ENERGIA(x) ((int)((x) * ESCALA_ENERGIA))
+
+//que imprime simular en consola
+#define MOSTRAR_NADA 0
+#define MOSTRAR_CONTEOS 1
+#define MOSTRAR_MATRIZ 2 //conteos y matriz de cada tick
+
+// ===================================================
+// =================== ENUMS Y ESTRUCTURAS ===========
+// ===================================================
+
+/*
+En esta sección del código se definen estructuras y tipos para representar un ecosistema
+    en el que conviven diferentes tipos de seres vivos, con estados 
+    y acciones posibles.
+*/
+//tipos de ser vivos
+typedef enum {
+    VACIO, 
+    PLANTA, 
+    HERVIVORO, 
+    CARNIVORO 
+} TipoSerVivo;
+
+typedef enum {
+    NINGUNA,
+    MOVER,
+    COMER,
+    REPRODUCIRSE,
+    MORIR
+} Accion;
+
+
+/*
+Cada celda es una palabra de 32 bits con el ser vivo que la ocupa (0 si esta
+vacia). Antes era un puntero a un SerVivo de 20 bytes reservado con malloc;
+asi la matriz ocupa 4 bytes por celda y mover un ser vivo es copiar un entero.
+La `vida` no se usaba y ya no se guarda.
+
+    bits  0-1   tipo (TipoSerVivo)
+    bits  2-4   accion (Accion)
+    bits  5-12  tick de nacimiento (modulo 256)
+    bits 13-31  energia con signo en punto fijo (ESCALA_ENERGIA por unidad),
+                mas lo que el ser vivo gasta por tick desde el tick 0
+
+Edad y energia no se actualizan en cada tick: se calculan a partir del tick
+actual (edadDe, energiaDe). Los animales gastan ENERGIA(1) por tick, asi que
+guardar "energia + ticks transcurridos" deja fijo el campo mientras no comen
+ni se reproducen. Las plantas no gastan y guardan la energia tal cual.
+*/
+typedef uint32_t Celda;
+
+//metricas espaciales que se calculan en cada tick
+typedef struct {
+    int plantas;
+    int hervivoros;
+    int carnivoros;
+    int clusters;             // grupos de plantas conectadas (vecindad de 8)
+    int cluster_mayor;        // tamaño del grupo de plantas mas grande
+    float cluster_medio;      // tamaño promedio de los grupos de plantas
+    int en_peligro;           // hervivoros con un carnivoro al lado
+    float varianza_densidad;  // varianza de la ocupacion por bloque
+    int nacidos[4];           // nacimientos por tipo desde las estadisticas anteriores
+    int muertos[4];           // muertes por tipo desde las estadisticas anteriores
+} Estadisticas;
+
+
+//simulacion en curso (definida en ecosistema.c), ver crearMundo
+typedef struct Mundo Mundo;
+
+//tipo de los elementos de una Vista
+typedef enum {
+    DATO_CELDA  // uint32_t con el formato de Celda
+} TipoDato;
+
+/*
+Vista de solo lectura de una matriz del mundo, sin copia: el elemento (i, j)
+esta en datos + i * paso_fila + j * paso_col (pasos en bytes). Con DATO_CELDA
+cada elemento se decodifica con tipoDe, accionDe, edadDe(c, tick) y
+energiaDe(c, tick), o con los corrimientos DESP_* desde otro lenguaje.
+*/
+typedef struct {
+    const void* datos;
+    int filas, cols;
+    ptrdiff_t paso_fila; // bytes entre una fila y la siguiente
+    ptrdiff_t paso_col;  // bytes entre una columna y la siguiente
+    TipoDato dato;
+    int tick;            // ticks terminados, para leer edad y energia
+} Vista;
+
+
+// ===================================================
+// ================== FUNCIONES HELPERS ==============
+// ===================================================
+
+//lectura de los campos de una celda
+static inline TipoSerVivo tipoDe(Celda c) {
+    return (TipoSerVivo)(c & 0x3u);
+}
+
+static inline Accion accionDe(Celda c) {
+    return (Accion)((c >> DESP_ACCION) & 0x7u);
+}
+
+//edad despues de `tick` ticks terminados
+static inline int edadDe(Celda c, int tick) {
+    return (int)(((uint32_t)tick - (c >> DESP_NACIMIENTO)) & 0xFFu);
+}
+
+//gasto de energia acumulado hasta `tick`, ya corrido al campo de energia
+static inline uint32_t gastoHasta(Celda c, int tick) {
+    uint32_t gasta = tipoDe(c) >= HERVIVORO; //las plantas no gastan
+    return (gasta * (uint32_t)ENERGIA(1) * (uint32_t)tick) << DESP_ENERGIA;
+}
+
+//energia en punto fijo despues de `tick` ticks; el corrimiento aritmetico conserva el signo
+static inline int energiaDe(Celda c, int tick) {
+    return (int32_t)((c & ~((1u << DESP_ENERGIA) - 1)) - gastoHasta(c, tick)) >> DESP_ENERGIA;
+}
+
+// ===================================================
+// ==================== FUNCIONES ====================
+// ===================================================
+
+//motor
+int simular(int filas, int cols, int ticks, unsigned int semilla, int alto_banda, int mostrar);
+
+/*
+Uso como libreria: en vez de simular(), que hace todo de una vez, se crea un
+mundo, se puebla y se avanza de a varios ticks por llamada. Entre llamadas se
+pueden leer las estadisticas, copiar la matriz o mirarla sin copiar con una
+Vista.
+
+    Mundo* m = crearMundo(1024, 1024, 60, 0);
+    poblarMundo(m);
+    avanzarMundo(m, 100);
+    Vista v = vistaMundo(m);   // v.datos apunta a la matriz del mundo
+    liberarMundo(m);
+*/
+Mundo* crearMundo(int filas, int cols, unsigned int semilla, int alto_banda);
+int poblarMundo(Mundo* m);
+int avanzarMundo(Mundo* m, int ticks);
+void estadisticasMundo(const Mundo* m, Estadisticas* est);
+void copiarMundo(const Mundo* m, Celda* destino);
+Vista vistaMundo(const Mundo* m);
+void liberarMundo(Mundo* m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+/* Piezas internas de libecosistema: fases de un tick, matriz y escritura de
+ celdas. Lo usan el nucleo (ecosistema.c), el ejecutable (main.c) y el
+ benchmark (bench.c); quien solo usa la libreria incluye ecosistema.h.
+*/
+
+#ifndef ECOSISTEMA_INTERNO_H
+#define ECOSISTEMA_INTERNO_H
+
+// ===================================================
+// =============== LIBRERÍAS Y CONSTANTES ============
+// ===================================================
+#include "ecosistema.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#else
+// sin -fopenmp (ver compilacion de Windows en el README) todo corre en un solo hilo
+static inline int omp_get_thread_num(void) { return 0; }
+static inline int omp_get_num_threads(void) { return 1; }
+static inline int omp_get_max_threads(void) { return 1; }
+static inline void omp_set_num_threads(int hilos) { (void)hilos; }
+static inline double omp_get_wtime(void) { return (double)clock() / CLOCKS_PER_SEC; }
+#endif
+
+#define BLOQUE_DENSIDAD 4 //lado del bloque para medir la densidad local (varianza_densidad)
+
+//rango del campo de energia (ver Celda)
+#define ENERGIA_MIN (-(1 << (31 - DESP_ENERGIA)))
+#define ENERGIA_MAX ((1 << (31 - DESP_ENERGIA)) - 1)
+
+// ===================================================
+// =================== ENUMS Y ESTRUCTURAS ===========
+// ===================================================
+
+//eventos de un tick que anota cada hilo, indexados por TipoSerVivo
+typedef struct {
+    int nacidos[4];
+    int muertos[4];
+    int relleno[8];   // completa una linea de cache, cada hilo usa la suya
+} Contadores;
+
+//muertes programadas por banda (definida en ecosistema.c)
+typedef struct Agenda Agenda;
+
+//lo que recibe cada fase: que filas procesar, con que clave sortear y donde anotar
+typedef struct {
+    int ini, fin;        // filas [ini, fin) de la banda
+    uint32_t clave;      // clave de sorteo de esta fase en este tick
+    Contadores* cont;    // contadores del hilo que procesa la banda
+    int tick;            // ticks ya terminados, para leer edad y energia
+    int banda;           // banda que se procesa
+    Agenda* agenda;      // muertes programadas y plantas a revisar
+} Tramo;
+
+typedef void (*Fase)(Celda** grid, int filas, int cols, const Tramo* t);
+
+
+// ===================================================
+// ================== FUNCIONES HELPERS ==============
+// ===================================================
+
+//escritura de los campos, devuelven la celda modificada
+static inline Celda conAccion(Celda c, Accion accion) {
+    return (c & ~(0x7u << DESP_ACCION)) | ((uint32_t)accion << DESP_ACCION);
+}
+
+//fija la energia que tiene el ser vivo despues de `tick` ticks
+static inline Celda conEnergia(Celda c, int energia, int tick) {
+    if (energia < ENERGIA_MIN) energia = ENERGIA_MIN;
+    if (energia > ENERGIA_MAX) energia = ENERGIA_MAX;
+    return (c & ((1u << DESP_ENERGIA) - 1)) + ((uint32_t)energia << DESP_ENERGIA) + gastoHasta(c, tick);
+}
+
+//ser vivo que nace despues de `tick` ticks: edad 0 y sin accion
+static inline Celda crearSer(TipoSerVivo tipo, int energia, int tick) {
+    Celda c = (Celda)tipo | (((uint32_t)tick & 0xFFu) << DESP_NACIMIENTO);
+    return conEnergia(c, energia, tick);
+}
+
+// ===================================================
+// ==================== FUNCIONES ====================
+// ===================================================
+
+//matriz
+Celda** crearMatriz(int filas, int cols);
+void liberarMatriz(Celda** grid);
+Celda crearRandom(uint32_t sorteo);
+void poblarMatriz(Celda** grid, int filas, int cols, unsigned int semilla, Estadisticas* est);
+void imprimirMatriz(Celda** grid, int filas, int cols);
+uint64_t huellaMatriz(Celda** grid, int filas, int cols, int tick);
+
+//fases de un tick, cada una procesa las filas [t->ini, t->fin)
+void moverHerbivoros(Celda** grid, int filas, int cols, const Tramo* t);
+void moverCarnivoros(Celda** grid, int filas, int cols, const Tramo* t);
+void herbivorosConsume(Celda** grid, int filas, int cols, const Tramo* t);
+void carnivorosConsume(Celda** grid, int filas, int cols, const Tramo* t);
+void reproducirPlantas(Celda** grid, int filas, int cols, const Tramo* t);
+void reproducirHervivoros(Celda** grid, int filas, int cols, const Tramo* t);
+void reproducirCarnivoros(Celda** grid, int filas, int cols, const Tramo* t);
+void limpiarVencidos(Celda** grid, int filas, int cols, const Tramo* t);
+void limpiarMuertos(Celda** grid, int filas, int cols, const Tramo* t);
+void limpiarAcciones(Celda** grid, int filas, int cols, const Tramo* t);
+
+#endif
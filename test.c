@@ -0,0 +1,413 @@
+/* Pruebas de libecosistema: codificacion de la celda, invariantes de cada
+ tick y determinismo contra huellas de referencia.
+
+ Las huellas de referencia son la salida esperada del modo determinista
+ (ALTO_BANDA_DETERMINISTA) con la semilla de main; si cambian, cambio el
+ comportamiento de la simulacion. Para regenerarlas: `test --huellas`.
+
+ uso: test [--huellas]
+*/
+
+#include "ecosistema_interno.h"
+
+#ifndef HILOS_PRUEBA
+#define HILOS_PRUEBA 8 //el modo determinista se compara de 1 a este numero de hilos
+#endif
+#define SEMILLA_PRUEBA 60
+
+//simulacion de referencia: dimensiones, ticks y huella de la matriz en cada tick
+typedef struct {
+    int filas, cols, ticks;
+    const uint64_t* huellas;
+} Referencia;
+
+//la configuracion por defecto de main
+static const uint64_t HUELLAS_8X8[12] = {
+    0xc23ad57482cf1effull, 0x26c63f5b0a4b6ceaull, 0xdcc1d6cc7c9d59e9ull,
+    0xea571c0d95362507ull, 0xae5ef1cca7c33145ull, 0xc9702eeb5e022972ull,
+    0xe4a99a84ac62cd1eull, 0x10851959c88f6478ull, 0x129caedf0f96040full,
+    0x2f1fdf69fed34662ull, 0x3ba5ab87ef45d63aull, 0x394bc35dfaf0298cull
+};
+
+//dimensiones impares y varias bandas por hilo, con vencimientos que dan la vuelta a la rueda
+static const uint64_t HUELLAS_61X83[40] = {
+    0x8685135db7f85c84ull, 0xf9e9176dac090151ull, 0x1883966ba675b377ull,
+    0x489515a6bf58a7d7ull, 0x942b6d4541f7dd45ull, 0xed21f0a7ade96305ull,
+    0x99aecb68dfe78a02ull, 0x337024e10764854dull, 0x3608413304bb9c0dull,
+    0x5f809480ca260385ull, 0x051b7f7af8fd662full, 0x3f26d7ca9a6c2293ull,
+    0xa7680498a2fa02b7ull, 0x4ad88fa4c9d082aaull, 0x5e553952e0a67594ull,
+    0x8418b3d8fd147e9bull, 0x392b336aca87b72dull, 0xc17d9b4040364619ull,
+    0xdc05ba412fea68f5ull, 0x212604c85bf208deull, 0x3215130361180f7full,
+    0x82d35405db2cb793ull, 0x48214589f9f9eb78ull, 0x38df4f89352fd21bull,
+    0xdf274dd1bf273c33ull, 0xa2ca9f8e2c3486d1ull, 0xfaf86e056d240435ull,
+    0x90dbf63f8f345c44ull, 0xeb6803e219d47cd3ull, 0x3d3af4480d88d3dbull,
+    0x1d79db9aca2d349eull, 0xcd2f4ca4b15161b7ull, 0xd5798d7634fc4f35ull,
+    0x05ad2388130ccae4ull, 0x07f2ccd7949f9108ull, 0x28f4032a8a197c5aull,
+    0xcdb8ad4d14c0d6d6ull, 0x9067d55de42e89deull, 0x9df1ad660fadbbf4ull,
+    0x25624aa1a066677full
+};
+
+static const Referencia REFERENCIAS[] = {
+    {8, 8, 12, HUELLAS_8X8},
+    {61, 83, 40, HUELLAS_61X83},
+};
+#define NUM_REFERENCIAS ((int)(sizeof(REFERENCIAS) / sizeof(REFERENCIAS[0])))
+
+
+// ===================================================
+// =================== CODIFICACIÓN ==================
+// ===================================================
+
+/*
+    Compara la celda empaquetada contra la semantica del SerVivo con floats:
+    todos los tipos y acciones deben leerse igual que se escribieron, la edad
+    tiene que avanzar uno por tick desde el nacimiento (tambien cuando el tick
+    pasa de 255 o el campo de energia da la vuelta), y la energia debe dar lo
+    mismo que un float que pierde 1 por tick y recibe las mismas sumas y
+    restas que hacen los kernels (±1, ±2), incluidas las comparaciones contra
+    3.0 y -3.0.
+
+    Retorna:
+        - La cantidad de diferencias encontradas (0 si son equivalentes).
+*/
+static int comprobarCodificacion(void) {
+    int errores = 0;
+    const int nacimientos[5] = {0, 1, 255, 70000, 2000000000};
+
+    for (int tipo = VACIO; tipo <= CARNIVORO; tipo++) {
+        for (int accion = NINGUNA; accion <= MORIR; accion++) {
+            for (int n = 0; n < 5; n++) {
+                int nacio = nacimientos[n];
+                Celda c = conAccion(crearSer(tipo, ENERGIA(80), nacio), accion);
+                for (int edad = 0; edad <= EDAD_MAX; edad++) {
+                    int gasto = tipo >= HERVIVORO ? ENERGIA(edad) : 0;
+                    if (tipoDe(c) != (TipoSerVivo)tipo || accionDe(c) != (Accion)accion ||
+                        edadDe(c, nacio + edad) != edad || energiaDe(c, nacio + edad) != ENERGIA(80) - gasto) {
+                        errores++;
+                    }
+                }
+            }
+        }
+    }
+
+    const float deltas[4] = {-1.0f, 1.0f, 2.0f, -2.0f};
+    float energia = 70.0f;
+    int tick = 0;
+    Celda c = crearSer(HERVIVORO, ENERGIA(70), tick);
+    unsigned int x = 12345u; //generador propio, independiente de la semilla del mundo
+    for (int paso = 0; paso < 100000; paso++) {
+        x = x * 1103515245u + 12345u;
+        float d = deltas[(x >> 16) % 4];
+        if (energia > 200.0f && d > 0) d = -d; //se mantiene en el rango de la simulacion
+        if (energia < -200.0f && d < 0) d = -d;
+
+        if ((x >> 20) % 2 && energia > -200.0f) {
+            tick++; //pasa un tick: gasta 1 sin tocar la celda
+            energia -= 1.0f;
+        } else {
+            energia += d;
+            c = conEnergia(c, energiaDe(c, tick) + ENERGIA(d), tick);
+        }
+
+        if ((float)energiaDe(c, tick) / ESCALA_ENERGIA != energia ||
+            (energia >= 3.0f) != (energiaDe(c, tick) >= ENERGIA(3)) ||
+            (energia < -3.0f) != (energiaDe(c, tick) < ENERGIA(-3)) ||
+            tipoDe(c) != HERVIVORO) {
+            errores++;
+        }
+    }
+    return errores;
+}
+
+
+// ===================================================
+// ==================== INVARIANTES ==================
+// ===================================================
+
+/*
+    Revisa los invariantes del tick que acaba de terminar:
+        - Balance por tipo: lo que cambio cada conteo tiene que ser igual a
+          nacidos - muertos. Con celdas empaquetadas, que dos seres vivos
+          ocupen la misma celda significa que uno piso al otro sin registrar
+          su muerte, y eso rompe el balance.
+        - Toda celda ocupada tiene una accion valida.
+    No hay punteros por ser vivo, asi que ya no puede haber uso despues de
+    liberar; el resto de la memoria la revisa una compilacion con
+    -fsanitize=address.
+
+    Retorna:
+        - La cantidad de invariantes que fallaron.
+*/
+static int verificarInvariantes(Celda** grid, int filas, int cols, int tick, const Estadisticas* previo, const Estadisticas* est) {
+    const char* nombres[4] = {"vacio", "plantas", "hervivoros", "carnivoros"};
+    int antes[4] = {0, previo->plantas, previo->hervivoros, previo->carnivoros};
+    int ahora[4] = {0, est->plantas, est->hervivoros, est->carnivoros};
+    int errores = 0;
+
+    for (int tipo = PLANTA; tipo <= CARNIVORO; tipo++) {
+        int esperado = antes[tipo] + est->nacidos[tipo] - est->muertos[tipo];
+        if (ahora[tipo] != esperado) {
+            printf("tick %d: %s = %d, se esperaban %d (%d + %d nacidos - %d muertos)\n",
+                   tick, nombres[tipo], ahora[tipo], esperado, antes[tipo], est->nacidos[tipo], est->muertos[tipo]);
+            errores++;
+        }
+    }
+    for (int i = 0; i < filas; i++) {
+        for (int j = 0; j < cols; j++) {
+            if (grid[i][j] != CELDA_VACIA && accionDe(grid[i][j]) > MORIR) {
+                printf("tick %d: celda (%d, %d) con accion invalida\n", tick, i, j);
+                errores++;
+            }
+        }
+    }
+    return errores;
+}
+
+/*
+    Recalcula en serie, por fuerza bruta, las metricas que analizarEcosistema
+    arma en paralelo (union-find por hilo mezclado en arbol, ocupacion por
+    bloque con sumas atomicas solo en los bloques partidos) y las compara con
+    las del mundo:
+        - conteos por tipo;
+        - grupos de plantas con vecindad de 8, recorridos en anchura: cantidad,
+          el mas grande y el promedio;
+        - hervivoros con un carnivoro en su vecindad de 8;
+        - varianza de la ocupacion en bloques de BLOQUE_DENSIDAD, sumando en
+          el mismo orden que el analisis para que el resultado sea identico.
+
+    Retorna:
+        - La cantidad de metricas que no coinciden.
+*/
+static int verificarMetricas(Celda** grid, int filas, int cols, int tick, const Estadisticas* est) {
+    Estadisticas e = {0};
+    int* cola = malloc((size_t)filas * cols * sizeof(int));
+    char* visto = calloc((size_t)filas * cols, 1);
+
+    for (int i = 0; i < filas; i++) {
+        for (int j = 0; j < cols; j++) {
+            switch (tipoDe(grid[i][j])) {
+                case PLANTA: e.plantas++; break;
+                case HERVIVORO: e.hervivoros++; break;
+                case CARNIVORO: e.carnivoros++; break;
+                default: break;
+            }
+            int peligro = 0, grupo = 0, n = 0;
+            for (int ni = i - 1; ni <= i + 1; ni++) {
+                for (int nj = j - 1; nj <= j + 1; nj++) {
+                    if (ni >= 0 && ni < filas && nj >= 0 && nj < cols && tipoDe(grid[ni][nj]) == CARNIVORO) peligro = 1;
+                }
+            }
+            if (tipoDe(grid[i][j]) == HERVIVORO) e.en_peligro += peligro;
+
+            if (tipoDe(grid[i][j]) != PLANTA || visto[i * cols + j]) continue;
+            // grupo nuevo: recorrido en anchura desde (i, j)
+            visto[i * cols + j] = 1;
+            cola[n++] = i * cols + j;
+            while (grupo < n) {
+                int ci = cola[grupo] / cols, cj = cola[grupo] % cols;
+                grupo++;
+                for (int ni = ci - 1; ni <= ci + 1; ni++) {
+                    for (int nj = cj - 1; nj <= cj + 1; nj++) {
+                        if (ni < 0 || ni >= filas || nj < 0 || nj >= cols) continue;
+                        if (tipoDe(grid[ni][nj]) != PLANTA || visto[ni * cols + nj]) continue;
+                        visto[ni * cols + nj] = 1;
+                        cola[n++] = ni * cols + nj;
+                    }
+                }
+            }
+            e.clusters++;
+            if (n > e.cluster_mayor) e.cluster_mayor = n;
+        }
+    }
+    e.cluster_medio = e.clusters > 0 ? (float)e.plantas / e.clusters : 0.0f;
+
+    int bloques_f = (filas + BLOQUE_DENSIDAD - 1) / BLOQUE_DENSIDAD;
+    int bloques_c = (cols + BLOQUE_DENSIDAD - 1) / BLOQUE_DENSIDAD;
+    double suma = 0.0, suma2 = 0.0;
+    for (int bf = 0; bf < bloques_f; bf++) {
+        for (int bc = 0; bc < bloques_c; bc++) {
+            int ocupados = 0, area = 0;
+            for (int i = bf * BLOQUE_DENSIDAD; i < filas && i < (bf + 1) * BLOQUE_DENSIDAD; i++) {
+                for (int j = bc * BLOQUE_DENSIDAD; j < cols && j < (bc + 1) * BLOQUE_DENSIDAD; j++) {
+                    ocupados += grid[i][j] != CELDA_VACIA;
+                    area++;
+                }
+            }
+            double d = (double)ocupados / area;
+            suma += d;
+            suma2 += d * d;
+        }
+    }
+    double media = suma / (bloques_f * bloques_c);
+    e.varianza_densidad = (float)(suma2 / (bloques_f * bloques_c) - media * media);
+
+    free(cola);
+    free(visto);
+
+    int errores = e.plantas != est->plantas || e.hervivoros != est->hervivoros || e.carnivoros != est->carnivoros ||
+                  e.clusters != est->clusters || e.cluster_mayor != est->cluster_mayor ||
+                  e.cluster_medio != est->cluster_medio || e.en_peligro != est->en_peligro ||
+                  e.varianza_densidad != est->varianza_densidad;
+    if (errores) {
+        printf("tick %d: metricas %d/%d/%d grupos %d (mayor %d, promedio %.3f) peligro %d varianza %.6f, "
+               "se esperaban %d/%d/%d grupos %d (mayor %d, promedio %.3f) peligro %d varianza %.6f\n",
+               tick, est->plantas, est->hervivoros, est->carnivoros, est->clusters, est->cluster_mayor,
+               est->cluster_medio, est->en_peligro, est->varianza_densidad, e.plantas, e.hervivoros,
+               e.carnivoros, e.clusters, e.cluster_mayor, e.cluster_medio, e.en_peligro, e.varianza_densidad);
+    }
+    return errores;
+}
+
+/*
+    Avanza un mundo de a un tick con `hilos` hilos, revisa los invariantes y
+    las metricas de cada tick y guarda la huella de la matriz en `huellas`
+    (una por tick).
+
+    Retorna:
+        - La cantidad de invariantes que fallaron.
+*/
+static int correrPrueba(int filas, int cols, int ticks, int alto_banda, int hilos, uint64_t* huellas) {
+    int errores = 0;
+    omp_set_num_threads(hilos); //el mundo fija sus hilos al crearse
+    Mundo* m = crearMundo(filas, cols, SEMILLA_PRUEBA, alto_banda);
+    Celda** copia = crearMatriz(filas, cols);
+    Estadisticas previo, est;
+    poblarMundo(m);
+    estadisticasMundo(m, &previo);
+
+    for (int tick = 0; tick < ticks; tick++) {
+        avanzarMundo(m, 1);
+        estadisticasMundo(m, &est);
+        copiarMundo(m, copia[0]);
+        errores += verificarInvariantes(copia, filas, cols, tick, &previo, &est);
+        errores += verificarMetricas(copia, filas, cols, tick, &est);
+        huellas[tick] = huellaMatriz(copia, filas, cols, vistaMundo(m).tick);
+        previo = est;
+    }
+
+    liberarMatriz(copia);
+    liberarMundo(m);
+    return errores;
+}
+
+/*
+    Avanza todos los ticks en una sola llamada y deja la huella final en
+    `huella`. Nacidos y muertos suman toda la llamada, asi que el balance se
+    revisa entre la poblacion inicial y la final.
+
+    Retorna:
+        - La cantidad de invariantes que fallaron.
+*/
+static int correrDeUnaVez(int filas, int cols, int ticks, int alto_banda, uint64_t* huella) {
+    Mundo* m = crearMundo(filas, cols, SEMILLA_PRUEBA, alto_banda);
+    Celda** copia = crearMatriz(filas, cols);
+    Estadisticas inicial, est;
+    poblarMundo(m);
+    estadisticasMundo(m, &inicial);
+    avanzarMundo(m, ticks);
+    estadisticasMundo(m, &est);
+    copiarMundo(m, copia[0]);
+    int errores = verificarInvariantes(copia, filas, cols, ticks - 1, &inicial, &est);
+    errores += verificarMetricas(copia, filas, cols, ticks - 1, &est);
+    *huella = huellaMatriz(copia, filas, cols, vistaMundo(m).tick);
+    liberarMatriz(copia);
+    liberarMundo(m);
+    return errores;
+}
+
+
+// ===================================================
+// ======================== MAIN =====================
+// ===================================================
+
+//imprime las huellas de referencia con el formato de las tablas de arriba
+static int imprimirHuellas(void) {
+    for (int r = 0; r < NUM_REFERENCIAS; r++) {
+        const Referencia* ref = &REFERENCIAS[r];
+        uint64_t* huellas = malloc(ref->ticks * sizeof(uint64_t));
+        correrPrueba(ref->filas, ref->cols, ref->ticks, ALTO_BANDA_DETERMINISTA, 1, huellas);
+        printf("%dx%d, %d ticks:", ref->filas, ref->cols, ref->ticks);
+        for (int t = 0; t < ref->ticks; t++) {
+            printf("%s0x%016llxull%s", t % 3 ? " " : "\n    ", (unsigned long long)huellas[t], t + 1 < ref->ticks ? "," : "");
+        }
+        printf("\n");
+        free(huellas);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--huellas") == 0) return imprimirHuellas();
+    int fallas = 0;
+
+    int diferencias = comprobarCodificacion();
+    printf("Codificacion de celdas: %s (%d diferencias)\n", diferencias ? "ERROR" : "OK", diferencias);
+    fallas += diferencias;
+
+    // modo determinista: con cualquier cantidad de hilos, las huellas de cada
+    // tick tienen que ser las de referencia
+    int max_hilos = omp_get_max_threads();
+    for (int r = 0; r < NUM_REFERENCIAS; r++) {
+        const Referencia* ref = &REFERENCIAS[r];
+        uint64_t* huellas = malloc(ref->ticks * sizeof(uint64_t));
+        int errores = 0;
+        for (int hilos = 1; hilos <= HILOS_PRUEBA; hilos++) {
+            int invariantes = correrPrueba(ref->filas, ref->cols, ref->ticks, ALTO_BANDA_DETERMINISTA, hilos, huellas);
+            if (invariantes) {
+                printf("%dx%d: con %d hilos fallaron %d invariantes\n", ref->filas, ref->cols, hilos, invariantes);
+                errores++;
+            }
+            if (memcmp(huellas, ref->huellas, ref->ticks * sizeof(uint64_t)) != 0) {
+                printf("%dx%d: con %d hilos las huellas no coinciden con las de referencia\n", ref->filas, ref->cols, hilos);
+                errores++;
+            }
+        }
+        // avanzar de a varios ticks por llamada tiene que dar lo mismo
+        uint64_t final;
+        int balance = correrDeUnaVez(ref->filas, ref->cols, ref->ticks, ALTO_BANDA_DETERMINISTA, &final);
+        if (balance || final != ref->huellas[ref->ticks - 1]) {
+            printf("%dx%d: avanzando todo en una llamada fallan %d invariantes o cambia el resultado\n", ref->filas, ref->cols, balance);
+            errores++;
+        }
+        printf("Determinismo %dx%d de 1 a %d hilos: %s\n", ref->filas, ref->cols, HILOS_PRUEBA, errores ? "ERROR" : "OK");
+        free(huellas);
+        fallas += errores;
+    }
+
+    // modo normal: el resultado depende de los hilos, pero los invariantes no
+    uint64_t huellas[40];
+    int invariantes = correrPrueba(61, 83, 40, 0, HILOS_PRUEBA, huellas);
+    printf("Invariantes con bandas segun %d hilos: %s (%d fallas)\n", HILOS_PRUEBA, invariantes ? "ERROR" : "OK", invariantes);
+    fallas += invariantes;
+
+    // metricas en formas chicas y raras: mas hilos que bandas, hilos sin
+    // filas, bloques partidos entre hilos y columnas que no llenan un bloque
+    const int formas[][2] = {{1, 9}, {2, 2}, {3, 17}, {5, 5}, {9, 1}, {17, 3}, {29, 40}, {64, 64}};
+    const int altos[2] = {0, 3};
+    uint64_t huellas_forma[10];
+    int metricas = 0;
+    for (int f = 0; f < (int)(sizeof(formas) / sizeof(formas[0])); f++) {
+        for (int a = 0; a < 2; a++) {
+            for (int hilos = 1; hilos <= HILOS_PRUEBA + 1; hilos++) {
+                metricas += correrPrueba(formas[f][0], formas[f][1], 10, altos[a], hilos, huellas_forma);
+            }
+        }
+    }
+    printf("Metricas contra el calculo en serie: %s (%d fallas)\n", metricas ? "ERROR" : "OK", metricas);
+    fallas += metricas;
+    omp_set_num_threads(max_hilos);
+
+    // errores de la API
+    int api = 0;
+    if (crearMundo(0, 8, SEMILLA_PRUEBA, 0) != NULL) api++;
+    if (simular(8, 0, 1, SEMILLA_PRUEBA, 0, MOSTRAR_NADA) != -1) api++;
+    Mundo* m = crearMundo(8, 8, SEMILLA_PRUEBA, 0);
+    poblarMundo(m);
+    avanzarMundo(m, 1);
+    if (poblarMundo(m) != -1) api++; //ya avanzo
+    liberarMundo(m);
+    printf("Errores de la API: %s\n", api ? "ERROR" : "OK");
+    fallas += api;
+
+    return fallas ? 1 : 0;
+}